@@ -13,11 +13,117 @@
 #pragma ide diagnostic ignored "cert-msc51-cpp"
 #pragma ide diagnostic ignored "cert-msc50-cpp"
 #pragma ide diagnostic ignored "cert-err58-cpp"
+#include <algorithm>
 #include <cstdint>
+#include <cstring>
 #include <fcntl.h>
+#include <functional>
+#include <istream>
+#include <memory>
+#include <streambuf>
+#include <string>
+#include <thread>
+#include <vector>
+#include <zstd.h>
 #include "libzstd-seek/zstd-seek.h"
 #include "gtest/gtest.h"
 
+//load a whole file in memory, the result is empty if the file can't be read
+static std::vector<uint8_t> readAsset(const char *file){
+    std::vector<uint8_t> buff;
+    FILE* f = fopen(file, "rb");
+    if(f == nullptr){
+        return buff;
+    }
+
+    fseek(f, 0, SEEK_END);
+    buff.resize(ftell(f));
+
+    fseek(f, 0, SEEK_SET);
+    if(fread(buff.data(), 1, buff.size(), f) != buff.size()){
+        buff.clear();
+    }
+    fclose(f);
+
+    return buff;
+}
+
+//owns a context, so it is freed even when a failed ASSERT returns early from a test
+struct ZSTDSeekContextDeleter {
+    void operator()(ZSTDSeek_Context *sctx) const {
+        ZSTDSeek_free(sctx);
+    }
+};
+typedef std::unique_ptr<ZSTDSeek_Context, ZSTDSeekContextDeleter> ZSTDSeekContextPtr;
+
+//a seekable std::streambuf on top of a context, so an archive can be read with a std::istream
+class ZSTDSeekStreamBuf : public std::streambuf {
+public:
+    explicit ZSTDSeekStreamBuf(ZSTDSeek_Context *sctx) : sctx(sctx) {
+        setg(buff, buff, buff);//an empty get area, never a null one
+    }
+
+protected:
+    int_type underflow() override {
+        size_t n = ZSTDSeek_read(buff, sizeof(buff), sctx);
+        if(n == 0){
+            return traits_type::eof();
+        }
+        setg(buff, buff, buff+n);
+        return traits_type::to_int_type(buff[0]);
+    }
+
+    //large reads skip the get area and are decompressed straight into the caller's buffer
+    std::streamsize xsgetn(char *s, std::streamsize n) override {
+        std::streamsize done = std::min<std::streamsize>(n, egptr()-gptr());
+        memcpy(s, gptr(), done);
+        gbump(done);
+        if(n-done >= (std::streamsize)sizeof(buff)){
+            done += ZSTDSeek_read(s+done, n-done, sctx);
+        }else if(done < n){
+            done += std::streambuf::xsgetn(s+done, n-done);
+        }
+        return done;
+    }
+
+    pos_type seekoff(off_type off, std::ios_base::seekdir dir, std::ios_base::openmode) override {
+        if(off == 0 && dir == std::ios_base::cur){//tellg(), keep what is left in the get area
+            return pos_type(ZSTDSeek_tell(sctx)-(egptr()-gptr()));
+        }
+        int origin = SEEK_SET;
+        if(dir == std::ios_base::cur){
+            origin = SEEK_CUR;
+            off -= egptr()-gptr();//the context is ahead of the stream by what is left in the get area
+        }else if(dir == std::ios_base::end){
+            origin = SEEK_END;
+        }
+        if(ZSTDSeek_seek(sctx, off, origin) != 0){
+            return pos_type(off_type(-1));
+        }
+        setg(buff, buff, buff);
+        return pos_type(ZSTDSeek_tell(sctx));
+    }
+
+    pos_type seekpos(pos_type pos, std::ios_base::openmode which) override {
+        return seekoff(off_type(pos), std::ios_base::beg, which);
+    }
+
+private:
+    ZSTDSeek_Context *sctx;
+    char buff[4096];
+};
+
+//read at offset without moving the position of the context, like pread(2)
+static size_t ZSTDSeekPread(ZSTDSeek_Context *sctx, void *buff, size_t size, long offset){
+    long pos = ZSTDSeek_tell(sctx);
+    if(ZSTDSeek_seek(sctx, offset, SEEK_SET) != 0){
+        return 0;
+    }
+    size_t ret = ZSTDSeek_read(buff, size, sctx);
+    ZSTDSeek_seek(sctx, pos, SEEK_SET);
+    return ret;
+}
+
 TEST(ZSTDSeekInvalid, InvalidArguments) {
     ASSERT_EQ(ZSTDSeek_getJumpTableOfContext(nullptr), nullptr);
 
@@ -776,6 +882,60 @@ TEST(ZSTDSeekTest100K, JumpTable) {
     ZSTDSeek_free(sctx);
 }
 
+//test that every frame is found at its exact position, even if the frame size must be learned decompressing it
+TEST(ZSTDSeekTest100K, JumpTableRecords) {
+    ZSTDSeekContextPtr sctx(ZSTDSeek_createFromFile("test_assets/100K.zst"));
+    ASSERT_NE (sctx, nullptr);
+
+    ZSTDSeek_JumpTable *jt = ZSTDSeek_getJumpTableOfContext(sctx.get());
+    ASSERT_NE (jt, nullptr);
+
+    ASSERT_EQ(jt->length, 101);
+
+    for(uint32_t i = 0; i < jt->length; i++){
+        ZSTDSeek_JumpTableRecord r = jt->records[i];
+        ASSERT_EQ(r.compressedPos, i*30);
+        ASSERT_EQ(r.uncompressedPos, i*1000);
+    }
+}
+
+//build the jump table of the same file from many threads at once, each one must match the one built serially
+TEST(ZSTDSeekTest100K, JumpTableConcurrent) {
+    ZSTDSeekContextPtr sctx(ZSTDSeek_createFromFile("test_assets/100K.zst"));
+    ASSERT_NE (sctx, nullptr);
+
+    ZSTDSeek_JumpTable *jt = ZSTDSeek_getJumpTableOfContext(sctx.get());
+    ASSERT_NE (jt, nullptr);
+
+    const int nThreads = 8;
+    std::vector<int> mismatches(nThreads, 0);
+    std::vector<std::thread> threads;
+
+    for(int t=0; t<nThreads; t++){
+        threads.emplace_back([jt, t, &mismatches](){
+            ZSTDSeekContextPtr tsctx(ZSTDSeek_createFromFile("test_assets/100K.zst"));
+            ZSTDSeek_JumpTable *tjt = ZSTDSeek_getJumpTableOfContext(tsctx.get());
+            if(!tjt || tjt->length != jt->length){
+                mismatches[t]++;
+            }else{
+                for(uint32_t i = 0; i < jt->length; i++){
+                    if(tjt->records[i].compressedPos != jt->records[i].compressedPos || tjt->records[i].uncompressedPos != jt->records[i].uncompressedPos){
+                        mismatches[t]++;
+                    }
+                }
+            }
+        });
+    }
+
+    for(auto &thread : threads){
+        thread.join();
+    }
+
+    for(int t=0; t<nThreads; t++){
+        ASSERT_EQ(mismatches[t], 0);
+    }
+}
+
 //test seek_end and tell, it should match the file size
 TEST(ZSTDSeekTest100K, SeekEndTellFileSize) {
     ZSTDSeek_Context* sctx = ZSTDSeek_createFromFile("test_assets/100K.zst");
@@ -908,6 +1068,278 @@ TEST(ZSTDSeekTest100K, SeekEndFuzzy) {
     ZSTDSeek_free(sctx);
 }
 
+//a corrupted frame must not prevent opening the file, it's detected when the frame is read:
+//the frames before the corrupted 51st one must be read, the read must stop short of the end and not skip the corrupted frame on the next read
+static void checkCorrupted51stFrame(std::vector<uint8_t> &buff){
+    std::vector<char> out(100000);
+    ZSTDSeekContextPtr sctx(ZSTDSeek_create(buff.data(), buff.size()));
+    ASSERT_NE (sctx, nullptr);
+
+    int ret;
+
+    ret = ZSTDSeek_read(out.data(), 100000, sctx.get());
+    ASSERT_GE(ret, 50000);
+    ASSERT_NE(ret, 100000);
+    for(int i=0; i<50000; i++){
+        ASSERT_EQ(out[i], '0'+(i%10));
+    }
+
+    ASSERT_EQ(ZSTDSeek_tell(sctx.get()), ret);
+
+    ret = ZSTDSeek_read(out.data(), 100000, sctx.get());
+    ASSERT_EQ(ret, 0);
+
+    //the frames before the corrupted one are still readable
+    ret = ZSTDSeek_seek(sctx.get(), 0, SEEK_SET);
+    ASSERT_EQ(ret, 0);
+
+    ret = ZSTDSeek_read(out.data(), 50000, sctx.get());
+    ASSERT_EQ(ret, 50000);
+    for(int i=0; i<50000; i++){
+        ASSERT_EQ(out[i], '0'+(i%10));
+    }
+}
+
+//corrupt a byte of the payload of the 51st frame, the content checksum must not match anymore
+TEST(ZSTDSeekTest100K, CorruptedPayload) {
+    std::vector<uint8_t> buff = readAsset("test_assets/100K.zst");
+    ASSERT_FALSE(buff.empty());
+
+    ASSERT_EQ(buff[50*30+15], '5');
+    buff[50*30+15] = '7'; //the literals of the frame start at byte 10
+
+    checkCorrupted51stFrame(buff);
+}
+
+//corrupt the content checksum of the 51st frame
+TEST(ZSTDSeekTest100K, CorruptedChecksum) {
+    std::vector<uint8_t> buff = readAsset("test_assets/100K.zst");
+    ASSERT_FALSE(buff.empty());
+
+    buff[51*30-1] ^= 0xFF; //the checksum is in the last 4 bytes of the frame
+
+    checkCorrupted51stFrame(buff);
+}
+
+//randomly jump around reading a random buffer size, return how many reads did not return the expected digits
+static int fuzzyRead100K(ZSTDSeek_Context *sctx, unsigned int seed, int iterations){
+    std::vector<char> buff(100000);
+    int errors = 0, j, len;
+
+    for(int i=0; i<iterations; i++){
+        j = rand_r(&seed)%100000;
+        len = 1+(rand_r(&seed)%(100000-j));
+
+        if(ZSTDSeek_seek(sctx, j, SEEK_SET) != 0 || (int)ZSTDSeek_read(buff.data(), len, sctx) != len){
+            errors++;
+            continue;
+        }
+        for(int w=0; w < len; w++){
+            if(buff[w] != '0'+((j+w)%10)){
+                errors++;
+                break;
+            }
+        }
+    }
+
+    return errors;
+}
+
+//many threads, each with its own context on the same file
+TEST(ZSTDSeekTest100K, ContextPerThreadFuzzy) {
+    const int nThreads = 8;
+    std::vector<int> errors(nThreads, -1);
+    std::vector<std::thread> threads;
+
+    for(int t=0; t<nThreads; t++){
+        threads.emplace_back([t, &errors](){
+            ZSTDSeekContextPtr sctx(ZSTDSeek_createFromFile("test_assets/100K.zst"));
+            if(sctx){
+                errors[t] = fuzzyRead100K(sctx.get(), t, 200);
+            }
+        });
+    }
+
+    for(auto &thread : threads){
+        thread.join();
+    }
+
+    for(int t=0; t<nThreads; t++){
+        ASSERT_EQ(errors[t], 0);
+    }
+}
+
+//many threads, each with its own context on the same buffer in memory
+TEST(ZSTDSeekTest100K, SharedBufferFuzzy) {
+    std::vector<uint8_t> buff = readAsset("test_assets/100K.zst");
+    ASSERT_FALSE(buff.empty());
+    size_t size = buff.size();
+
+    const int nThreads = 8;
+    std::vector<int> errors(nThreads, -1);
+    std::vector<std::thread> threads;
+
+    for(int t=0; t<nThreads; t++){
+        threads.emplace_back([t, size, &buff, &errors](){
+            ZSTDSeekContextPtr sctx(ZSTDSeek_create(buff.data(), size));
+            if(sctx){
+                errors[t] = fuzzyRead100K(sctx.get(), t, 200);
+            }
+        });
+    }
+
+    for(auto &thread : threads){
+        thread.join();
+    }
+
+    for(int t=0; t<nThreads; t++){
+        ASSERT_EQ(errors[t], 0);
+    }
+}
+
+//one seek or read of an access trace, with what the context returned when it was recorded
+struct TraceOp {
+    uint8_t read;
+    int8_t origin;
+    int64_t offset;//the offset of a seek or the length of a read
+    int64_t result;
+    int64_t tell;
+    uint64_t hash;//FNV-1a of the bytes returned by a read, so the trace can be replayed against any archive
+};
+
+//every operation is stored as 34 bytes, the fields in the order above, little endian
+static const size_t traceOpSize = 1+1+8+8+8+8;
+
+static void appendTraceField(std::string &trace, uint64_t value, int bytes){
+    for(int i=0; i<bytes; i++){
+        trace.push_back((char)(value >> 8*i));
+    }
+}
+
+static uint64_t parseTraceField(const char *&at, int bytes){
+    uint64_t value = 0;
+    for(int i=0; i<bytes; i++){
+        value |= (uint64_t)(uint8_t)*at++ << 8*i;
+    }
+    return value;
+}
+
+static void appendTraceOp(std::string &trace, const TraceOp &op){
+    appendTraceField(trace, op.read, 1);
+    appendTraceField(trace, (uint8_t)op.origin, 1);
+    appendTraceField(trace, op.offset, 8);
+    appendTraceField(trace, op.result, 8);
+    appendTraceField(trace, op.tell, 8);
+    appendTraceField(trace, op.hash, 8);
+}
+
+static TraceOp parseTraceOp(const char *at){
+    TraceOp op;
+    op.read = parseTraceField(at, 1);
+    op.origin = (int8_t)parseTraceField(at, 1);
+    op.offset = parseTraceField(at, 8);
+    op.result = parseTraceField(at, 8);
+    op.tell = parseTraceField(at, 8);
+    op.hash = parseTraceField(at, 8);
+    return op;
+}
+
+//run the seek or read of op on a context and store in op what it returned
+static void runTraceOp(ZSTDSeek_Context *sctx, TraceOp &op, std::vector<char> &buff){
+    op.hash = 0;
+    if(op.read){
+        buff.resize(std::max<int64_t>(op.offset, 1));
+        op.result = ZSTDSeek_read(buff.data(), op.offset, sctx);
+        op.hash = 14695981039346656037ULL;
+        for(int64_t w=0; w < op.result; w++){
+            op.hash = (op.hash ^ (uint8_t)buff[w]) * 1099511628211ULL;
+        }
+    }else{
+        op.result = ZSTDSeek_seek(sctx, op.offset, op.origin);
+    }
+    op.tell = ZSTDSeek_tell(sctx);
+}
+
+//replay a binary trace against a context, return how many operations did not behave as recorded
+static int replayTrace(ZSTDSeek_Context *sctx, const std::string &trace){
+    std::vector<char> buff;
+    int errors = 0;
+
+    for(size_t at = 0; at+traceOpSize <= trace.size(); at += traceOpSize){
+        TraceOp recorded = parseTraceOp(trace.data()+at);
+        TraceOp op = recorded;
+        runTraceOp(sctx, op, buff);
+
+        if(op.result != recorded.result || op.tell != recorded.tell || op.hash != recorded.hash){
+            errors++;
+        }
+    }
+
+    return errors;
+}
+
+//record a trace of random seeks and reads, including the failing ones, store it in a file,
+//then replay it against the same file, a buffer in memory and files with the same content but different frames
+TEST(ZSTDSeekTest100K, TraceRecordReplay) {
+    ZSTDSeekContextPtr sctx(ZSTDSeek_createFromFile("test_assets/100K.zst"));
+    ASSERT_NE (sctx, nullptr);
+
+    std::vector<char> buff;
+    std::string trace;
+    int origins[] = {SEEK_SET, SEEK_CUR, SEEK_END};
+
+    srand(0);
+
+    for(int i=0; i<1000; i++){
+        TraceOp op = {};
+        if(i%2){
+            op.read = 1;
+            op.offset = rand()%100000;
+        }else{
+            op.origin = origins[rand()%3];
+            op.offset = rand()%110000-(op.origin == SEEK_SET ? 5000 : 105000);
+        }
+        runTraceOp(sctx.get(), op, buff);
+        appendTraceOp(trace, op);
+    }
+
+    ASSERT_EQ(trace.size(), 1000*traceOpSize);
+
+    std::unique_ptr<FILE, decltype(&fclose)> f(tmpfile(), &fclose);
+    ASSERT_NE(f, nullptr);
+    ASSERT_EQ(fwrite(trace.data(), 1, trace.size(), f.get()), trace.size());
+    rewind(f.get());
+
+    std::string loaded(trace.size(), 0);
+    ASSERT_EQ(fread(&loaded[0], 1, loaded.size(), f.get()), loaded.size());
+    ASSERT_EQ(fgetc(f.get()), EOF);
+    ASSERT_EQ(loaded, trace);
+
+    ZSTDSeekContextPtr fsctx(ZSTDSeek_createFromFile("test_assets/100K.zst"));
+    ASSERT_NE (fsctx, nullptr);
+    ASSERT_EQ(replayTrace(fsctx.get(), loaded), 0);
+
+    std::vector<uint8_t> compressed = readAsset("test_assets/100K.zst");
+    ASSERT_FALSE(compressed.empty());
+
+    ZSTDSeekContextPtr bsctx(ZSTDSeek_create(compressed.data(), compressed.size()));
+    ASSERT_NE (bsctx, nullptr);
+    ASSERT_EQ(replayTrace(bsctx.get(), loaded), 0);
+
+    ZSTDSeekContextPtr ssctx(ZSTDSeek_createFromFile("test_assets/100K_single_frame.zst"));
+    ASSERT_NE (ssctx, nullptr);
+    ASSERT_EQ(replayTrace(ssctx.get(), loaded), 0);
+
+    ZSTDSeekContextPtr rsctx(ZSTDSeek_createFromFile("test_assets/100K_reframed.zst"));
+    ASSERT_NE (rsctx, nullptr);
+    ASSERT_EQ(replayTrace(rsctx.get(), loaded), 0);
+
+    //a different content must be noticed
+    ZSTDSeekContextPtr lsctx(ZSTDSeek_createFromFile("test_assets/lines.zst"));
+    ASSERT_NE (lsctx, nullptr);
+    ASSERT_GT(replayTrace(lsctx.get(), loaded), 0);
+}
+
 //try to read more than 100KB
 TEST(ZSTDSeekTest100K, ReadTooMuch) {
     ZSTDSeek_Context* sctx = ZSTDSeek_createFromFile("test_assets/100K.zst");
@@ -932,4 +1364,673 @@ TEST(ZSTDSeekTest100K, ReadTooMuch) {
     ZSTDSeek_free(sctx);
 }
 
+/*
+ * 100K_single_frame.zst and 100K_reframed.zst have the same content of 100K.zst.
+ * 100K_single_frame.zst is a single frame encoded without uncompressed frame size,
+ * 100K_reframed.zst is the same content split in 25 frames of 4096 bytes (the last one is shorter), encoded with uncompressed frame size.
+ *
+ * it's a test to make sure that splitting a file in frames of a target size doesn't change what is read
+ * */
+
+TEST(ZSTDSeekTest100KFraming, SingleFrame) {
+    ZSTDSeekContextPtr sctx(ZSTDSeek_createFromFile("test_assets/100K_single_frame.zst"));
+    ASSERT_NE (sctx, nullptr);
+
+    ASSERT_EQ(ZSTDSeek_isMultiframe(sctx.get()), 0);
+
+    ASSERT_EQ(ZSTDSeek_getNumberOfFrames(sctx.get()), 1);
+
+    ASSERT_EQ(ZSTDSeek_uncompressedFileSize(sctx.get()), 100000);
+
+    ASSERT_EQ(fuzzyRead100K(sctx.get(), 0, 100), 0);
+}
+
+TEST(ZSTDSeekTest100KFraming, Reframed) {
+    ZSTDSeekContextPtr sctx(ZSTDSeek_createFromFile("test_assets/100K_reframed.zst"));
+    ASSERT_NE (sctx, nullptr);
+
+    ASSERT_EQ(ZSTDSeek_isMultiframe(sctx.get()), 1);
+
+    ASSERT_EQ(ZSTDSeek_getNumberOfFrames(sctx.get()), (100000+4096-1)/4096);
+
+    ZSTDSeek_JumpTable *jt = ZSTDSeek_getJumpTableOfContext(sctx.get());
+    ASSERT_NE (jt, nullptr);
+
+    for(uint32_t i = 0; i < jt->length; i++){
+        ASSERT_EQ(jt->records[i].uncompressedPos, std::min<size_t>(i*4096, 100000));
+    }
+
+    ASSERT_EQ(fuzzyRead100K(sctx.get(), 0, 100), 0);
+}
+
+//decompress a context sequentially and compress it again in frames of frameSize bytes, holding a single frame in memory at a time
+static std::vector<uint8_t> reframe(ZSTDSeek_Context *sctx, size_t frameSize){
+    std::vector<uint8_t> out;
+    std::vector<char> frame(frameSize);
+    std::vector<uint8_t> compressed(ZSTD_compressBound(frameSize));
+    std::unique_ptr<ZSTD_CCtx, decltype(&ZSTD_freeCCtx)> cctx(ZSTD_createCCtx(), &ZSTD_freeCCtx);
+    ZSTD_CCtx_setParameter(cctx.get(), ZSTD_c_checksumFlag, 1);
+    size_t ret, total = 0;
+
+    if(ZSTDSeek_seek(sctx, 0, SEEK_SET) != 0){
+        return std::vector<uint8_t>();
+    }
+    while((ret = ZSTDSeek_read(frame.data(), frameSize, sctx)) > 0){
+        size_t size = ZSTD_compress2(cctx.get(), compressed.data(), compressed.size(), frame.data(), ret);
+        if(ZSTD_isError(size)){
+            return std::vector<uint8_t>();
+        }
+        out.insert(out.end(), compressed.begin(), compressed.begin()+size);
+        total += ret;
+    }
+
+    if(total != ZSTDSeek_uncompressedFileSize(sctx)){//the read stopped before the end
+        return std::vector<uint8_t>();
+    }
+
+    return out;
+}
+
+//reframe the single frame file and 100K.zst in frames of 4096 bytes, what is read must not change
+TEST(ZSTDSeekTest100KFraming, Reframe) {
+    const char *sources[] = {"test_assets/100K_single_frame.zst", "test_assets/100K.zst"};
+
+    for(const char *source : sources){
+        ZSTDSeekContextPtr original(ZSTDSeek_createFromFile(source));
+        ASSERT_NE (original, nullptr);
+
+        std::vector<uint8_t> buff = reframe(original.get(), 4096);
+        ASSERT_FALSE(buff.empty());
+
+        ZSTDSeekContextPtr reframed(ZSTDSeek_create(buff.data(), buff.size()));
+        ASSERT_NE (reframed, nullptr);
+
+        std::vector<char> a(200000), b(200000);
+        int ret, j, len;
+
+        ASSERT_EQ(ZSTDSeek_seek(original.get(), 0, SEEK_SET), 0);
+
+        ret = ZSTDSeek_read(a.data(), a.size(), original.get());
+        ASSERT_EQ(ret, 100000);
+
+        ret = ZSTDSeek_read(b.data(), b.size(), reframed.get());
+        ASSERT_EQ(ret, 100000);
+
+        ASSERT_EQ(memcmp(a.data(), b.data(), 100000), 0);
+
+        srand(0);
+
+        for(int i=0; i<100; i++){
+
+            j = rand()%100000;
+            len = 1+(rand()%(100000-j));
+
+            ASSERT_EQ(ZSTDSeek_seek(original.get(), j, SEEK_SET), 0);
+            ASSERT_EQ(ZSTDSeek_seek(reframed.get(), j, SEEK_SET), 0);
+
+            ret = ZSTDSeek_read(a.data(), len, original.get());
+            ASSERT_EQ(ret, len);
+            ret = ZSTDSeek_read(b.data(), len, reframed.get());
+            ASSERT_EQ(ret, len);
+
+            ASSERT_EQ(memcmp(a.data(), b.data(), len), 0);
+        }
+    }
+}
+
+/*
+ * magic_in_payload.zst is composed of 8 frames of 25 bytes each, encoded without uncompressed frame size.
+ * The frame i contains the zstd magic number (28 B5 2F FD) followed by 60 times the letter 'a'+i,
+ * so the magic number appears also inside every frame, 10 bytes after the real start of the frame.
+ *
+ * it's a test to make sure frames are found by chaining their sizes and never by looking for the magic number
+ * */
+
+TEST(ZSTDSeekTestMagicInPayload, JumpTable) {
+    ZSTDSeek_Context* sctx = ZSTDSeek_createFromFile("test_assets/magic_in_payload.zst");
+    ASSERT_NE (sctx, nullptr);
+
+    ZSTDSeek_JumpTable *jt = ZSTDSeek_getJumpTableOfContext(sctx);
+    ASSERT_NE (jt, nullptr);
+
+    ASSERT_EQ(jt->length, 9);
+
+    for(uint32_t i = 0; i < jt->length; i++){
+        ZSTDSeek_JumpTableRecord r = jt->records[i];
+        ASSERT_EQ(r.compressedPos, i*25);
+        ASSERT_EQ(r.uncompressedPos, i*64);
+    }
+
+    ASSERT_EQ(ZSTDSeek_getNumberOfFrames(sctx), 8);
+
+    ASSERT_EQ(ZSTDSeek_uncompressedFileSize(sctx), 512);
+
+    ZSTDSeek_free(sctx);
+}
+
+TEST(ZSTDSeekTestMagicInPayload, ReadSeqAll) {
+    ZSTDSeek_Context* sctx = ZSTDSeek_createFromFile("test_assets/magic_in_payload.zst");
+    ASSERT_NE (sctx, nullptr);
+
+    uint8_t buff[1000];
+    int ret;
+
+    ret = ZSTDSeek_read(buff, 1000, sctx);
+    ASSERT_EQ(ret, 512);
+
+    for(int i=0; i<8; i++){
+        uint8_t *frame = buff+i*64;
+        ASSERT_EQ(frame[0], 0x28);
+        ASSERT_EQ(frame[1], 0xB5);
+        ASSERT_EQ(frame[2], 0x2F);
+        ASSERT_EQ(frame[3], 0xFD);
+        for(int j=4; j<64; j++){
+            ASSERT_EQ(frame[j], 'a'+i);
+        }
+    }
+
+    ZSTDSeek_free(sctx);
+}
+
+/*
+ * skippable.zst is composed of 3 data frames interleaved with 3 skippable frames:
+ * Frame1 (at 0): ABCD
+ * Skippable (at 17, magic 0x184D2A50): meta
+ * Frame2 (at 29): EFGH
+ * Skippable (at 46, magic 0x184D2A5E): 12345678
+ * Frame3 (at 62): IJKL
+ * Skippable (at 79, magic 0x184D2A5F): END!
+ *
+ * skippable frames carry metadata, like seek tables, and must be transparent when reading
+ * */
+
+//every frame has its own record, the skippable ones decompress to 0 bytes
+TEST(ZSTDSeekTestSkippable, JumpTable) {
+    ZSTDSeekContextPtr sctx(ZSTDSeek_createFromFile("test_assets/skippable.zst"));
+    ASSERT_NE (sctx, nullptr);
+
+    ZSTDSeek_JumpTable *jt = ZSTDSeek_getJumpTableOfContext(sctx.get());
+    ASSERT_NE (jt, nullptr);
+
+    ASSERT_EQ(jt->length, 7);
+
+    size_t expectedCompressedPos[] = {0, 17, 29, 46, 62, 79, 91};
+    size_t expectedUncompressedPos[] = {0, 4, 4, 8, 8, 12, 12};
+
+    for(uint32_t i = 0; i < jt->length; i++){
+        ZSTDSeek_JumpTableRecord r = jt->records[i];
+        ASSERT_EQ(r.compressedPos, expectedCompressedPos[i]);
+        ASSERT_EQ(r.uncompressedPos, expectedUncompressedPos[i]);
+    }
+
+    ASSERT_EQ(ZSTDSeek_isMultiframe(sctx.get()), 1);
+
+    ASSERT_EQ(ZSTDSeek_uncompressedFileSize(sctx.get()), 12);
+}
+
+//fetch the payload of the skippable frames from the compressed extents in the jump table, without decompressing anything
+TEST(ZSTDSeekTestSkippable, Payloads) {
+    std::vector<uint8_t> buff = readAsset("test_assets/skippable.zst");
+    ASSERT_FALSE(buff.empty());
+
+    ZSTDSeekContextPtr sctx(ZSTDSeek_createWithoutJumpTable(buff.data(), buff.size()));
+    ASSERT_NE (sctx, nullptr);
+
+    ASSERT_EQ(ZSTDSeek_initializeJumpTable(sctx.get()), 0);
+
+    ZSTDSeek_JumpTable *jt = ZSTDSeek_getJumpTableOfContext(sctx.get());
+    ASSERT_NE (jt, nullptr);
+    ASSERT_EQ(jt->length, 7);
+
+    uint32_t expectedMagic[] = {0x184D2A50, 0x184D2A5E, 0x184D2A5F};
+    std::string expectedPayload[] = {"meta", "12345678", "END!"};
+    int found = 0;
+
+    for(uint32_t i = 0; i+1 < jt->length; i++){
+        const uint8_t *frame = buff.data()+jt->records[i].compressedPos;
+        size_t frameSize = jt->records[i+1].compressedPos-jt->records[i].compressedPos;
+        ASSERT_GE(frameSize, 8);
+
+        uint32_t magic = frame[0] | frame[1] << 8 | frame[2] << 16 | (uint32_t)frame[3] << 24;
+        bool skippable = (magic & 0xFFFFFFF0) == 0x184D2A50;
+
+        //the skippable frames, and only them, decompress to 0 bytes in this file
+        ASSERT_EQ(jt->records[i+1].uncompressedPos == jt->records[i].uncompressedPos, skippable);
+        if(!skippable){
+            continue;
+        }
+        ASSERT_LT(found, 3);
+
+        uint32_t payloadSize = frame[4] | frame[5] << 8 | frame[6] << 16 | (uint32_t)frame[7] << 24;
+        ASSERT_EQ(magic, expectedMagic[found]);
+        ASSERT_EQ(payloadSize, frameSize-8);
+        ASSERT_EQ(std::string((const char*)frame+8, payloadSize), expectedPayload[found]);
+
+        found++;
+    }
+
+    ASSERT_EQ(found, 3);
+}
+
+TEST(ZSTDSeekTestSkippable, ReadSeqAll) {
+    ZSTDSeek_Context* sctx = ZSTDSeek_createFromFile("test_assets/skippable.zst");
+    ASSERT_NE (sctx, nullptr);
+
+    char buff[100];
+    size_t pos;
+    int ret;
+
+    ret = ZSTDSeek_read(buff, 100, sctx);
+    ASSERT_EQ(ret, 12);
+    for(int i=0; i<12; i++){
+        ASSERT_EQ(buff[i], 'A'+i);
+    }
+
+    pos = ZSTDSeek_tell(sctx);
+    ASSERT_EQ(pos, 12);
+
+    ZSTDSeek_free(sctx);
+}
+
+//fuzzy test, randomly jump around 10000 times reading a random buffer size, across the skippable frames
+TEST(ZSTDSeekTestSkippable, SeekSetFuzzy) {
+    ZSTDSeek_Context* sctx = ZSTDSeek_createFromFile("test_assets/skippable.zst");
+    ASSERT_NE (sctx, nullptr);
+
+    char buff[100];
+    size_t pos;
+    int ret, j, len;
+
+    srand(0);
+
+    for(int i=0; i<10000; i++){
+
+        j = rand()%12;
+        len = 1+(rand()%(12-j));
+
+        ret = ZSTDSeek_seek(sctx, j, SEEK_SET);
+        ASSERT_EQ(ret, 0);
+
+        pos = ZSTDSeek_tell(sctx);
+        ASSERT_EQ(pos, j);
+
+        ret = ZSTDSeek_read(buff, len, sctx);
+        ASSERT_EQ(ret, len);
+        for(int k=j, w=0; w < len; k++, w++){
+            ASSERT_EQ(buff[w], 'A' + k);
+        }
+
+        pos = ZSTDSeek_tell(sctx);
+        ASSERT_EQ(pos, j+len);
+    }
+
+    ZSTDSeek_free(sctx);
+}
+
+/*
+ * lines.zst contains 10000 lines, the line n is "line n\n", for a total of 98890 bytes.
+ * It is split in 25 frames of 4096 bytes (the last one is shorter), encoded without uncompressed frame size,
+ * so many lines straddle two frames.
+ *
+ * it's a test for random access by line number through an index of line offsets in uncompressed coordinates
+ * */
+
+//scan the whole file and return the offset of the first line and of every interval-th line after it, empty if the file can't be scanned
+static std::vector<size_t> lineIndex(ZSTDSeek_Context *sctx, size_t interval){
+    std::vector<size_t> index;
+    char buff[1000];
+    size_t pos = 0, line = 0, ret;
+    size_t size = ZSTDSeek_uncompressedFileSize(sctx);
+
+    if(ZSTDSeek_seek(sctx, 0, SEEK_SET) != 0){
+        return index;
+    }
+
+    index.push_back(0);
+    while((ret = ZSTDSeek_read(buff, sizeof(buff), sctx)) > 0){
+        for(size_t i=0; i<ret; i++){
+            if(buff[i] == '\n' && ++line % interval == 0 && pos+i+1 < size){
+                index.push_back(pos+i+1);
+            }
+        }
+        pos += ret;
+    }
+
+    return index;
+}
+
+TEST(ZSTDSeekTestLines, LineIndex) {
+    ZSTDSeekContextPtr sctx(ZSTDSeek_createFromFile("test_assets/lines.zst"));
+    ASSERT_NE (sctx, nullptr);
+
+    ASSERT_EQ(ZSTDSeek_getNumberOfFrames(sctx.get()), 25);
+
+    std::vector<size_t> index = lineIndex(sctx.get(), 1);
+    ASSERT_EQ(index.size(), 10000);
+
+    char buff[100], expected[100];
+    size_t offset = 0;
+    int ret;
+
+    for(int n=0; n<10000; n++){
+        int len = snprintf(expected, sizeof(expected), "line %d\n", n);
+        ASSERT_EQ(index[n], offset);
+        offset += len;
+
+        ret = ZSTDSeek_seek(sctx.get(), index[n], SEEK_SET);
+        ASSERT_EQ(ret, 0);
+
+        ret = ZSTDSeek_read(buff, len, sctx.get());
+        ASSERT_EQ(ret, len);
+        ASSERT_EQ(memcmp(buff, expected, len), 0);
+    }
+
+    ASSERT_EQ(offset, ZSTDSeek_uncompressedFileSize(sctx.get()));
+}
+
+//keep only one line offset every 64 lines, reach the others skipping lines after the seek
+TEST(ZSTDSeekTestLines, SeekLineSampledFuzzy) {
+    ZSTDSeekContextPtr sctx(ZSTDSeek_createFromFile("test_assets/lines.zst"));
+    ASSERT_NE (sctx, nullptr);
+
+    const int interval = 64;
+    std::vector<size_t> index = lineIndex(sctx.get(), interval);
+    ASSERT_EQ(index.size(), (10000+interval-1)/interval);
+
+    char buff[1000], expected[100];
+    int ret, n;
+
+    srand(0);
+
+    for(int i=0; i<1000; i++){
+        n = rand()%10000;
+        int len = snprintf(expected, sizeof(expected), "line %d\n", n);
+
+        ret = ZSTDSeek_seek(sctx.get(), index[n/interval], SEEK_SET);
+        ASSERT_EQ(ret, 0);
+
+        ret = ZSTDSeek_read(buff, sizeof(buff), sctx.get());
+        ASSERT_GT(ret, 0);
+
+        int start = 0;
+        for(int skip = n%interval; skip > 0; start++){
+            ASSERT_LT(start, ret);
+            if(buff[start] == '\n'){
+                skip--;
+            }
+        }
+
+        ASSERT_LE(start+len, ret);
+        ASSERT_EQ(memcmp(buff+start, expected, len), 0);
+    }
+}
+
+/*
+ * search.zst contains 20000 bytes, the lowercase alphabet again and again, split in 20 frames of 1000 bytes,
+ * encoded without uncompressed frame size.
+ * The pattern REQ-1234 overwrites the alphabet at the offsets 0, 123, 996, 2500, 4999, 5007, 9993, 15000 and 19992,
+ * so some matches straddle two frames, one is at the start of a frame and one ends at the end of the file.
+ *
+ * it's a test for searching a pattern frame by frame without missing the matches on the boundaries
+ * */
+
+static const std::string searchPattern = "REQ-1234";
+static const std::vector<size_t> searchExpected = {0, 123, 996, 2500, 4999, 5007, 9993, 15000, 19992};
+
+//append to matches the offsets, shifted by base, of the matches in data that start before limit
+static void searchBuffer(const char *data, size_t len, size_t base, size_t limit, std::vector<size_t> &matches){
+    const char *end = data+len;
+    std::boyer_moore_horspool_searcher<std::string::const_iterator> searcher(searchPattern.begin(), searchPattern.end());
+    for(const char *it = std::search(data, end, searcher); it != end && (size_t)(it-data) < limit; it = std::search(it+1, end, searcher)){
+        matches.push_back(base+(it-data));
+    }
+}
+
+//read the file sequentially in small chunks, keeping the tail of the previous chunk for the matches straddling two chunks
+TEST(ZSTDSeekTestSearch, Sequential) {
+    ZSTDSeekContextPtr sctx(ZSTDSeek_createFromFile("test_assets/search.zst"));
+    ASSERT_NE (sctx, nullptr);
+
+    ASSERT_EQ(ZSTDSeek_getNumberOfFrames(sctx.get()), 20);
+
+    const size_t overlap = searchPattern.size()-1;
+    std::vector<char> buff(777+overlap);
+    size_t kept = 0, base = 0, ret;
+    std::vector<size_t> matches;
+
+    while((ret = ZSTDSeek_read(buff.data()+kept, buff.size()-kept, sctx.get())) > 0){
+        size_t len = kept+ret;
+        searchBuffer(buff.data(), len, base, len, matches);
+
+        kept = std::min(overlap, len);
+        memmove(buff.data(), buff.data()+len-kept, kept);
+        base += len-kept;
+    }
+
+    ASSERT_EQ(matches, searchExpected);
+}
+
+//search every frame on its own thread, reading a few bytes past its end, then merge the matches in order
+TEST(ZSTDSeekTestSearch, FramesParallel) {
+    ZSTDSeekContextPtr sctx(ZSTDSeek_createFromFile("test_assets/search.zst"));
+    ASSERT_NE (sctx, nullptr);
+
+    ZSTDSeek_JumpTable *jt = ZSTDSeek_getJumpTableOfContext(sctx.get());
+    ASSERT_NE (jt, nullptr);
+    ASSERT_EQ(jt->length, 21);
+
+    const size_t frames = jt->length-1;
+    std::vector<std::vector<size_t>> frameMatches(frames);
+    std::vector<int> errors(frames, 0);
+    std::vector<std::thread> threads;
+
+    for(size_t i=0; i<frames; i++){
+        size_t start = jt->records[i].uncompressedPos;
+        size_t frameLen = jt->records[i+1].uncompressedPos-start;
+        threads.emplace_back([i, start, frameLen, &frameMatches, &errors](){
+            ZSTDSeekContextPtr tsctx(ZSTDSeek_createFromFile("test_assets/search.zst"));
+            std::vector<char> buff(frameLen+searchPattern.size()-1);
+            if(!tsctx || ZSTDSeek_seek(tsctx.get(), start, SEEK_SET) != 0){
+                errors[i]++;
+                return;
+            }
+            size_t len = ZSTDSeek_read(buff.data(), buff.size(), tsctx.get());
+            if(len < frameLen){
+                errors[i]++;
+                return;
+            }
+            searchBuffer(buff.data(), len, start, frameLen, frameMatches[i]);
+        });
+    }
+
+    for(auto &thread : threads){
+        thread.join();
+    }
+
+    std::vector<size_t> matches;
+    for(size_t i=0; i<frames; i++){
+        ASSERT_EQ(errors[i], 0);
+        matches.insert(matches.end(), frameMatches[i].begin(), frameMatches[i].end());
+    }
+
+    ASSERT_EQ(matches, searchExpected);
+}
+
+//stop at the first match found after a given offset
+TEST(ZSTDSeekTestSearch, FirstMatchAfter) {
+    ZSTDSeekContextPtr sctx(ZSTDSeek_createFromFile("test_assets/search.zst"));
+    ASSERT_NE (sctx, nullptr);
+
+    char buff[100];
+    size_t from[] = {1, 997, 5000, 15001};
+    size_t expected[] = {123, 2500, 5007, 19992};
+    int ret;
+
+    for(int i=0; i<4; i++){
+        ret = ZSTDSeek_seek(sctx.get(), from[i], SEEK_SET);
+        ASSERT_EQ(ret, 0);
+
+        std::vector<size_t> matches;
+        size_t base = from[i], len;
+        while(matches.empty() && (len = ZSTDSeek_read(buff, sizeof(buff), sctx.get())) > 0){
+            searchBuffer(buff, len, base, len, matches);
+            if(matches.empty() && len == sizeof(buff)){//step back so a match straddling two reads is not missed
+                base += len-(searchPattern.size()-1);
+                ret = ZSTDSeek_seek(sctx.get(), base, SEEK_SET);
+                ASSERT_EQ(ret, 0);
+            }
+        }
+
+        ASSERT_FALSE(matches.empty());
+        ASSERT_EQ(matches[0], expected[i]);
+    }
+}
+
+/*
+ * the same archives read through the C++ helpers defined at the top of this file
+ * */
+
+TEST(ZSTDSeekTestCpp, ContextPtr) {
+    ZSTDSeekContextPtr sctx(ZSTDSeek_createFromFile("test_assets/seek_simple.zst"));
+    ASSERT_NE (sctx, nullptr);
+
+    ASSERT_EQ(ZSTDSeek_getNumberOfFrames(sctx.get()), 4);
+
+    ZSTDSeekContextPtr moved = std::move(sctx);
+    ASSERT_EQ (sctx, nullptr);
+    ASSERT_NE (moved, nullptr);
+
+    ASSERT_EQ(ZSTDSeek_uncompressedFileSize(moved.get()), 26);
+}
+
+TEST(ZSTDSeekTestCpp, StreamReadAll) {
+    ZSTDSeekContextPtr sctx(ZSTDSeek_createFromFile("test_assets/100K.zst"));
+    ASSERT_NE (sctx, nullptr);
+
+    ZSTDSeekStreamBuf sbuf(sctx.get());
+    std::istream in(&sbuf);
+
+    std::string data((std::istreambuf_iterator<char>(in)), std::istreambuf_iterator<char>());
+    ASSERT_EQ(data.size(), 100000);
+    for(size_t i=0; i<data.size(); i++){
+        ASSERT_EQ(data[i], '0'+(i%10));
+    }
+}
+
+//read() as the very first call, when nothing is in the get area yet
+TEST(ZSTDSeekTestCpp, StreamReadFirst) {
+    ZSTDSeekContextPtr sctx(ZSTDSeek_createFromFile("test_assets/100K.zst"));
+    ASSERT_NE (sctx, nullptr);
+
+    ZSTDSeekStreamBuf sbuf(sctx.get());
+    std::istream in(&sbuf);
+
+    std::vector<char> buff(10);
+    in.read(buff.data(), buff.size());
+    ASSERT_EQ(in.gcount(), 10);
+    for(size_t w=0; w < buff.size(); w++){
+        ASSERT_EQ(buff[w], '0'+(w%10));
+    }
+
+    buff.resize(50000);
+    in.read(buff.data(), buff.size());
+    ASSERT_EQ(in.gcount(), 50000);
+    for(size_t w=0; w < buff.size(); w++){
+        ASSERT_EQ(buff[w], '0'+((10+w)%10));
+    }
+
+    ASSERT_EQ(in.tellg(), 50010);
+}
+
+//tellg() must not throw away the get area, and large reads must go straight to the caller's buffer
+TEST(ZSTDSeekTestCpp, StreamTellAndDirectRead) {
+    ZSTDSeekContextPtr sctx(ZSTDSeek_createFromFile("test_assets/100K.zst"));
+    ASSERT_NE (sctx, nullptr);
+
+    ZSTDSeekStreamBuf sbuf(sctx.get());
+    std::istream in(&sbuf);
+
+    ASSERT_EQ(in.get(), '0');
+    ASSERT_EQ(ZSTDSeek_tell(sctx.get()), 4096);//the get area has been filled
+
+    ASSERT_EQ(in.tellg(), 1);
+    ASSERT_EQ(ZSTDSeek_tell(sctx.get()), 4096);//and it's still there
+
+    ASSERT_EQ(in.get(), '1');
+
+    std::vector<char> buff(50000);
+    in.read(buff.data(), buff.size());
+    ASSERT_EQ(in.gcount(), 50000);
+    for(size_t w=0; w < buff.size(); w++){
+        ASSERT_EQ(buff[w], '0'+((2+w)%10));
+    }
+
+    //4094 bytes came from the get area, the rest was read in place without reading ahead
+    ASSERT_EQ(ZSTDSeek_tell(sctx.get()), 50002);
+    ASSERT_EQ(in.tellg(), 50002);
+}
+
+TEST(ZSTDSeekTestCpp, Pread) {
+    ZSTDSeekContextPtr sctx(ZSTDSeek_createFromFile("test_assets/100K.zst"));
+    ASSERT_NE (sctx, nullptr);
+
+    char buff[100];
+    size_t ret;
+
+    ASSERT_EQ(ZSTDSeek_seek(sctx.get(), 12345, SEEK_SET), 0);
+
+    ret = ZSTDSeekPread(sctx.get(), buff, 100, 99950);
+    ASSERT_EQ(ret, 50);
+    for(size_t w=0; w < ret; w++){
+        ASSERT_EQ(buff[w], '0'+((99950+w)%10));
+    }
+
+    ASSERT_EQ(ZSTDSeek_tell(sctx.get()), 12345);
+
+    ret = ZSTDSeekPread(sctx.get(), buff, 100, 100001);
+    ASSERT_EQ(ret, 0);
+
+    ASSERT_EQ(ZSTDSeek_tell(sctx.get()), 12345);
+}
+
+//fuzzy test for seekg, randomly jump around 1000 times reading a random buffer size
+TEST(ZSTDSeekTestCpp, StreamSeekFuzzy) {
+    ZSTDSeekContextPtr sctx(ZSTDSeek_createFromFile("test_assets/100K.zst"));
+    ASSERT_NE (sctx, nullptr);
+
+    ZSTDSeekStreamBuf sbuf(sctx.get());
+    std::istream in(&sbuf);
+
+    std::vector<char> buff(100000);
+    int j, len;
+
+    srand(0);
+
+    for(int i=0; i<1000; i++){
+
+        j = rand()%100000;
+        len = 1+(rand()%(100000-j));
+
+        if(i%2){
+            in.seekg(j, std::ios_base::beg);
+        }else{
+            in.seekg(j-(long)in.tellg(), std::ios_base::cur);
+        }
+        ASSERT_TRUE(in.good());
+
+        ASSERT_EQ(in.tellg(), j);
+
+        in.read(buff.data(), len);
+        ASSERT_EQ(in.gcount(), len);
+        for(int w=0; w < len; w++){
+            ASSERT_EQ(buff[w], '0'+((j+w)%10));
+        }
+
+        ASSERT_EQ(in.tellg(), j+len);
+    }
+
+    in.seekg(1, std::ios_base::end);
+    ASSERT_TRUE(in.fail());
+}
+
 #pragma clang diagnostic pop